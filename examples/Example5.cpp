@@ -0,0 +1,62 @@
+#include "StateMachine/StateMachine2.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+enum class state {
+    state0,
+    state1,
+    state2
+};
+
+enum class event {
+    event1,
+    event2
+};
+
+static std::string to_string(const state &state) {
+    switch (state) {
+        case state::state0:
+            return "state0";
+        case state::state1:
+            return "state1";
+        case state::state2:
+            return "state2";
+    }
+    return "unknown";
+}
+
+namespace action {
+    const auto action1 = []() { std::cout << "action1" << std::endl; };
+    const auto action2 = []() { std::cout << "action2" << std::endl; };
+}// namespace action
+
+int main() {
+    transition_table_t<state, event> tt{
+            {{state::state0, event::event1}, {action::action1, state::state1}},
+            {{state::state1, event::event2}, {action::action2, state::state2}},
+    };
+
+    state_machine_t<state, event> sm(state::state0, tt);
+    std::cout << to_string(sm.get_state()) << std::endl;
+
+    sm.handle_event(event::event1);
+    std::cout << to_string(sm.get_state()) << std::endl;
+
+    std::thread patcher([&sm]() {
+        sm.add_transition({{state::state2, event::event1}, {action::action1, state::state1}});
+        sm.remove_transition(state::state0, event::event1);
+    });
+    patcher.join();
+
+    sm.handle_event(event::event2);
+    std::cout << to_string(sm.get_state()) << std::endl;
+
+    sm.handle_event(event::event1);
+    std::cout << to_string(sm.get_state()) << std::endl;
+
+    std::cout << sm.get_transition_table().size() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "StateMachine/StateMachine2.hpp"
+
+#include <iostream>
+#include <string>
+
+enum class state {
+    state0,
+    state1,
+    state2,
+    state3
+};
+
+enum class event {
+    event1,
+    event2
+};
+
+static std::string to_string(const state &state) {
+    switch (state) {
+        case state::state0:
+            return "state0";
+        case state::state1:
+            return "state1";
+        case state::state2:
+            return "state2";
+        case state::state3:
+            return "state3";
+    }
+    return "unknown";
+}
+
+static std::string to_string(const event &event) {
+    switch (event) {
+        case event::event1:
+            return "event1";
+        case event::event2:
+            return "event2";
+    }
+    return "unknown";
+}
+
+namespace action {
+    const auto action1 = []() { std::cout << "action1" << std::endl; };
+    const auto action2 = []() { std::cout << "action2" << std::endl; };
+}// namespace action
+
+int main() {
+    transition_table_t<state, event> tt{
+            {{state::state0, event::event1}, {action::action1, state::state1}},
+            {{state::state1, event::event2}, {action::action2, state::state2}},
+            {{state::state1, event::event2}, {action::action2, state::state0}},
+            {{state::state2, event::event1}, {action::action1, state::state1}},
+            {{state::state3, event::event1}, {action::action1, state::state0}},
+    };
+
+    const auto pruned = prune_transition_table(state::state0, tt);
+    std::cout << tt.size() << " -> " << pruned.size() << std::endl;
+
+    state_machine_t<state, event> sm(state::state0, pruned);
+
+    sm.set_enter_action(state::state1, []() { std::cout << "enter_action1" << std::endl; });
+    sm.set_leave_action(state::state1, []() { std::cout << "leave_action1" << std::endl; });
+
+    const auto state_to_string = [](const state &state) { return to_string(state); };
+    const auto event_to_string = [](const event &event) { return to_string(event); };
+    std::cout << sm.to_dot(state::state0, state_to_string, event_to_string);
+
+    return 0;
+}
@@ -25,9 +25,16 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -56,19 +63,111 @@ using transition_t = std::pair<std::pair<state_t, event_t>, std::tuple<guard_t<s
 template<typename state_t, typename event_t, typename data_t>
 using transition_table_t = std::vector<transition_t<state_t, event_t, data_t>>;
 
+template<typename state_t, typename event_t>
+using graph_t = std::pair<std::vector<state_t>, std::vector<std::vector<std::pair<event_t, std::size_t>>>>;
+
+template<typename state_t, typename event_t, typename data_t>
+transition_table_t<state_t, event_t, data_t> prune_transition_table(const state_t &state, const transition_table_t<state_t, event_t, data_t> &transition_table) {
+    std::unordered_map<state_t, std::vector<std::size_t>> outgoing;
+    for (std::size_t i = 0; i < transition_table.size(); ++i) {
+        const auto &key = transition_table[i].first;
+        auto &indices = outgoing[key.first];
+        const auto it = std::find_if(indices.begin(), indices.end(), [&](std::size_t j) {
+            return transition_table[j].first.second == key.second;
+        });
+        if (it == indices.end()) {
+            indices.push_back(i);
+        }
+    }
+    std::vector<bool> reachable(transition_table.size(), false);
+    std::unordered_set<state_t> visited{state};
+    std::vector<state_t> pending{state};
+    while (!pending.empty()) {
+        const state_t current = pending.back();
+        pending.pop_back();
+        const auto it = outgoing.find(current);
+        if (it == outgoing.end()) {
+            continue;
+        }
+        for (const std::size_t i : it->second) {
+            reachable[i] = true;
+            const state_t &next = std::get<2>(transition_table[i].second);
+            if (visited.insert(next).second) {
+                pending.push_back(next);
+            }
+        }
+    }
+    transition_table_t<state_t, event_t, data_t> pruned;
+    for (std::size_t i = 0; i < transition_table.size(); ++i) {
+        if (reachable[i]) {
+            pruned.push_back(transition_table[i]);
+        }
+    }
+    return pruned;
+}
+
+template<typename state_t, typename event_t, typename data_t>
+graph_t<state_t, event_t> to_graph(const transition_table_t<state_t, event_t, data_t> &transition_table) {
+    graph_t<state_t, event_t> graph;
+    std::unordered_map<state_t, std::size_t> indices;
+    const auto index_of = [&](const state_t &state) -> std::size_t {
+        const auto it = indices.find(state);
+        if (it != indices.end()) {
+            return it->second;
+        }
+        indices.emplace(state, graph.first.size());
+        graph.first.push_back(state);
+        graph.second.emplace_back();
+        return graph.first.size() - 1;
+    };
+    for (const transition_t<state_t, event_t, data_t> &transition : transition_table) {
+        const std::size_t source = index_of(transition.first.first);
+        const auto it = std::find_if(graph.second[source].begin(), graph.second[source].end(), [&](const std::pair<event_t, std::size_t> &edge) {
+            return edge.first == transition.first.second;
+        });
+        if (it != graph.second[source].end()) {
+            continue;
+        }
+        const std::size_t target = index_of(std::get<2>(transition.second));
+        graph.second[source].emplace_back(transition.first.second, target);
+    }
+    return graph;
+}
+
 template<typename state_t, typename event_t, typename data_t>
 class state_machine_t {
 public:
     state_machine_t() = default;
 
     state_machine_t(const state_t &state, transition_table_t<state_t, event_t, data_t> transition_table)
-        : m_state(state), m_transition_table(std::move(transition_table)) {}
+        : m_state(state), m_transition_table(new transition_table_t<state_t, event_t, data_t>(std::move(transition_table))) {}
+
+    state_machine_t(const state_machine_t &other) : m_state(other.m_state), m_transition_table(new transition_table_t<state_t, event_t, data_t>(other.get_transition_table())), m_enter_actions(other.m_enter_actions), m_leave_actions(other.m_leave_actions) {}
+
+    state_machine_t &operator=(const state_machine_t &other) {
+        if (this != &other) {
+            m_state = other.m_state;
+            set_transition_table(other.get_transition_table());
+            m_enter_actions = other.m_enter_actions;
+            m_leave_actions = other.m_leave_actions;
+        }
+        return *this;
+    }
+
+    ~state_machine_t() {
+        for (const auto &retired : m_retired) {
+            delete retired.first;
+        }
+        delete m_transition_table.load();
+    }
 
     bool handle_event(const event_t &event, const data_t &data) {
-        const auto it = std::find_if(m_transition_table.begin(), m_transition_table.end(), [&](const transition_t<state_t, event_t, data_t> &transition) {
+        const read_guard_t read_guard(*this);
+        const transition_table_t<state_t, event_t, data_t> &transition_table = *m_transition_table.load();
+        const auto it = std::find_if(transition_table.begin(), transition_table.end(), [&](const transition_t<state_t, event_t, data_t> &transition) {
             return transition.first.first == m_state && transition.first.second == event;
         });
-        if (it != m_transition_table.end()) {
+        if (it != transition_table.end()) {
             const auto &[guard, action, state] = it->second;
             if (guard(data)) {
                 const auto it1 = m_leave_actions.find(m_state);
@@ -93,7 +192,34 @@ public:
     }
 
     void set_transition_table(const transition_table_t<state_t, event_t, data_t> &transition_table) {
-        m_transition_table = transition_table;
+        std::unique_ptr<transition_table_t<state_t, event_t, data_t>> copy(new transition_table_t<state_t, event_t, data_t>(transition_table));
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        publish(copy.release());
+    }
+
+    void add_transition(const transition_t<state_t, event_t, data_t> &transition) {
+        update_transition_table([&](transition_table_t<state_t, event_t, data_t> &transition_table) {
+            const auto it = std::find_if(transition_table.begin(), transition_table.end(), [&](const transition_t<state_t, event_t, data_t> &other) {
+                return other.first == transition.first;
+            });
+            if (it != transition_table.end()) {
+                *it = transition;
+            } else {
+                transition_table.push_back(transition);
+            }
+        });
+    }
+
+    bool remove_transition(const state_t &state, const event_t &event) {
+        bool removed = false;
+        update_transition_table([&](transition_table_t<state_t, event_t, data_t> &transition_table) {
+            const auto it = std::remove_if(transition_table.begin(), transition_table.end(), [&](const transition_t<state_t, event_t, data_t> &transition) {
+                return transition.first.first == state && transition.first.second == event;
+            });
+            removed = it != transition_table.end();
+            transition_table.erase(it, transition_table.end());
+        });
+        return removed;
     }
 
     void set_enter_action(const state_t &state, const enter_action_t<state_t, data_t> &enter_action) {
@@ -109,7 +235,8 @@ public:
     }
 
     transition_table_t<state_t, event_t, data_t> get_transition_table() const {
-        return m_transition_table;
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return *m_transition_table.load();
     }
 
     enter_actions_t<state_t, data_t> get_enter_actions() const {
@@ -120,9 +247,105 @@ public:
         return m_leave_actions;
     }
 
+    template<typename state_to_string_t, typename event_to_string_t>
+    std::string to_dot(const state_t &state, state_to_string_t state_to_string, event_to_string_t event_to_string) const {
+        const auto escape = [](const std::string &string) {
+            std::string escaped;
+            for (const char c : string) {
+                if (c == '"' || c == '\\') {
+                    escaped += '\\';
+                }
+                escaped += c;
+            }
+            return escaped;
+        };
+        graph_t<state_t, event_t> graph;
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            graph = to_graph(*m_transition_table.load());
+        }
+        std::ostringstream dot;
+        dot << "digraph {\n";
+        for (std::size_t i = 0; i < graph.first.size(); ++i) {
+            std::string label = escape(state_to_string(graph.first[i]));
+            if (m_enter_actions.count(graph.first[i]) != 0 && m_leave_actions.count(graph.first[i]) != 0) {
+                label += "\\nenter / leave";
+            } else if (m_enter_actions.count(graph.first[i]) != 0) {
+                label += "\\nenter";
+            } else if (m_leave_actions.count(graph.first[i]) != 0) {
+                label += "\\nleave";
+            }
+            dot << "    " << i << " [label=\"" << label << "\"];\n";
+        }
+        const auto it = std::find(graph.first.begin(), graph.first.end(), state);
+        if (it != graph.first.end()) {
+            dot << "    start [shape=point];\n";
+            dot << "    start -> " << (it - graph.first.begin()) << ";\n";
+        }
+        for (std::size_t i = 0; i < graph.second.size(); ++i) {
+            for (const auto &edge : graph.second[i]) {
+                dot << "    " << i << " -> " << edge.second << " [label=\"" << escape(event_to_string(edge.first)) << "\"];\n";
+            }
+        }
+        dot << "}\n";
+        return dot.str();
+    }
+
 private:
+    class read_guard_t {
+    public:
+        explicit read_guard_t(state_machine_t &state_machine) : m_state_machine(state_machine) {
+            m_state_machine.m_readers.store(m_state_machine.m_readers.load(std::memory_order_relaxed) + 1);
+        }
+
+        read_guard_t(const read_guard_t &) = delete;
+
+        read_guard_t &operator=(const read_guard_t &) = delete;
+
+        ~read_guard_t() {
+            const std::size_t readers = m_state_machine.m_readers.load(std::memory_order_relaxed) - 1;
+            m_state_machine.m_readers.store(readers, std::memory_order_release);
+            if (readers == 0) {
+                m_state_machine.m_grace_periods.store(m_state_machine.m_grace_periods.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+        }
+
+    private:
+        state_machine_t &m_state_machine;
+    };
+
+    template<typename function_t>
+    void update_transition_table(function_t function) {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        std::unique_ptr<transition_table_t<state_t, event_t, data_t>> transition_table(new transition_table_t<state_t, event_t, data_t>(*m_transition_table.load()));
+        function(*transition_table);
+        publish(transition_table.release());
+    }
+
+    void publish(const transition_table_t<state_t, event_t, data_t> *transition_table) {
+        const transition_table_t<state_t, event_t, data_t> *retired = m_transition_table.exchange(transition_table);
+        if (m_readers.load() == 0) {
+            delete retired;
+        } else {
+            m_retired.emplace_back(retired, m_grace_periods.load(std::memory_order_acquire));
+        }
+        const std::size_t grace_periods = m_grace_periods.load(std::memory_order_acquire);
+        const auto it = std::remove_if(m_retired.begin(), m_retired.end(), [&](const std::pair<const transition_table_t<state_t, event_t, data_t> *, std::size_t> &retired) {
+            if (retired.second != grace_periods) {
+                delete retired.first;
+                return true;
+            }
+            return false;
+        });
+        m_retired.erase(it, m_retired.end());
+    }
+
     state_t m_state;
-    transition_table_t<state_t, event_t, data_t> m_transition_table;
+    std::atomic<const transition_table_t<state_t, event_t, data_t> *> m_transition_table{new transition_table_t<state_t, event_t, data_t>()};
+    std::atomic<std::size_t> m_readers{0};
+    std::atomic<std::size_t> m_grace_periods{0};
+    mutable std::mutex m_mutex;
+    std::vector<std::pair<const transition_table_t<state_t, event_t, data_t> *, std::size_t>> m_retired;
     enter_actions_t<state_t, data_t> m_enter_actions;
     leave_actions_t<state_t, data_t> m_leave_actions;
 };